@@ -345,10 +345,9 @@ fi
 if [ -s $procdir/${id}_rgrav_reduced ]; then
     grav="-g $procdir/${id}_rgrav_reduced"
 fi
-$shipcode/udmerge -i $id $nav $dpth $mag $grav | awk '{if ($8 != "nan" && $9 != "nan") print $0}' > $outid.dat
 
 # MGD77 header (check for h77 file in $dpath/h77 or use dummy)
-# Create a custom header items file for mgd77header -H option
+# Create a custom header items file for udmerge -H option (mgd77header -H format)
 echo "Survey_Identifier ${id:0:7}" > $temp.hdrpar.txt
 echo "Platform_Type_Code 1" >> $temp.hdrpar.txt
 echo "Platform_Type SHIP" >> $temp.hdrpar.txt
@@ -402,11 +401,15 @@ else
     fi
 fi
 
+# A stored h77 header takes precedence; otherwise udmerge builds the MGD77 header
+# from statistics gathered while merging, so the merged data file is not read again
+hdr=""
 if [ -s $outputdatapath/h77/$outid.h77 ]; then
     cat $outputdatapath/h77/$outid.h77 > $temp.$outid.h77
 else
-    gmt mgd77header -H$temp.hdrpar.txt $outid.dat -Mr > $temp.$outid.h77
+    hdr="-H $temp.hdrpar.txt -h $temp.$outid.h77"
 fi
+$shipcode/udmerge -i $id $nav $dpth $mag $grav $hdr | awk '{if ($8 != "nan" && $9 != "nan") print $0}' > $outid.dat
 
 mv -f $outid.dat $temp.$outid.dat
 
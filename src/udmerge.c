@@ -8,12 +8,22 @@
  
  Underway Data Merge: merge underway depth, magnetic, and gravity data with pos-mv navigation.
  
- To compile: cc -o udmerge udmerge.c
+ To compile: cc -o udmerge udmerge.c -lm
  
  Usage: udmerge -i <cruiseid> [-n /path/cruiseid_pos-mv] [-d /path/cruiseid_cdpth] [-m /path/cruiseid_cmagy] [-g /path/cruiseid_cgrav]
+                [-H /path/hdrpar.txt] [-h /path/cruiseid.h77] [-s /path/cruiseid.stats]
  
  Note: -i option required. One or more of n, d, m and g options required.
  
+ With -h, header statistics (time span, lat/lon extent, ten degree squares and
+ per-field counts, ranges and gaps) are accumulated while merging and a 24-line
+ MGD77 header is written to the given file, so the merged data need not be read
+ again to build it. -H supplies the remaining header items in mgd77header -H
+ format ("Item_Name value" per line); these override the computed items and
+ take effect only together with -h. With -s, the number of records, largest
+ navigation gap and per-field counts, ranges and largest gaps are written to
+ the given file.
+ 
  Input data follow SOEST convention for corrected data:
  
  For example:
@@ -49,6 +59,7 @@
 #include <string.h>
 #include <math.h>
 #include <stdio.h>
+#include <time.h>
 
 #ifndef MAXFLOAT
 	#ifdef FLT_MAX
@@ -58,6 +69,10 @@
 	#endif
 #endif
 #define DECYR_SLOP 1.90134e-9 /* The maximum time precision for MGD77 data, 0.06 seconds (1/60/60/24/365.24*.06) or 1.90134e-9 yr */
+#define MGD77_HDR_RECS 24   /* MGD77 header is 24 records of 80 characters */
+#define MGD77_HDR_LEN 80
+#define MGD77_MAX_TDI 29    /* Ten degree identifiers that fit in header records 16 and 17, leaving room for the 9999 terminator */
+#define NSTATFIELDS 8
 
 /* #define DEBUG  */
 
@@ -99,7 +114,48 @@ struct RECORD {
     int use;
 };
 
+/* Running statistics for one merged data field */
+struct FIELDSTATS {
+    char *name;
+    long n;
+    double min;
+    double max;
+    double last;    /* time (s) of the previous valid value */
+    double gap;     /* largest interval (s) between valid values */
+};
+
+/* Running statistics for the merged file, gathered as records are output */
+struct HDRSTATS {
+    long n;
+    int first_yy, first_jjj;
+    int last_yy, last_jjj;
+    double first_t, last_t;     /* times (s since 1970) of the first and last records */
+    double south, north;
+    double west, east;          /* longitude extent in -180/180 */
+    double west360, east360;    /* longitude extent in 0/360 */
+    double navgap;
+    char tdi[10000];            /* ten degree identifiers visited, indexed by code */
+    struct FIELDSTATS field[NSTATFIELDS];
+};
+
+/* Name, record, starting column and width of the MGD77 header items */
+struct HEADER_ITEM {
+    char *name;
+    int seq;
+    int col;
+    int width;
+};
+
 void kmoutput (struct RECORD *);
+void accumulate (struct HDRSTATS *, struct RECORD *);
+void fieldstats (struct FIELDSTATS *, double, double);
+void writeheader (struct HDRSTATS *, char *, char *, char *);
+void writestats (struct HDRSTATS *, char *);
+void lonextent (struct HDRSTATS *, double *, double *);
+void isotime (double, char *);
+void setitem (char [MGD77_HDR_RECS][MGD77_HDR_LEN+1], char *, char *);
+double epochsec (struct RECORD *);
+int tendegid (double, double);
 int setoutput (struct RECORD  *, struct RECORD  *, struct RECORD  *);
 void reset (struct RECORD *, struct RECORD *);
 int read (char *, struct RECORD *, FILE *, char *, int);
@@ -108,9 +164,86 @@ int ordday2mo (int, int);
 int ordday2dd (int, int);
 int isleapyear(int), dread, mread, gread, nread;
 
+struct HEADER_ITEM hdritems[] = {
+    {"Record_Type", 1, 1, 1},
+    {"Survey_Identifier", 1, 2, 8},
+    {"Format_Acronym", 1, 10, 5},
+    {"Data_Center_File_Number", 1, 15, 8},
+    {"Parameters_Surveyed_Code", 1, 23, 5},
+    {"File_Creation_Year", 1, 28, 4},
+    {"File_Creation_Month", 1, 32, 2},
+    {"File_Creation_Day", 1, 34, 2},
+    {"Source_Institution", 1, 36, 39},
+    {"Country", 2, 1, 18},
+    {"Platform_Name", 2, 19, 21},
+    {"Platform_Type_Code", 2, 40, 1},
+    {"Platform_Type", 2, 41, 6},
+    {"Chief_Scientist", 2, 47, 32},
+    {"Project_Cruise_Leg", 3, 1, 58},
+    {"Funding", 3, 59, 20},
+    {"Survey_Departure_Year", 4, 1, 4},
+    {"Survey_Departure_Month", 4, 5, 2},
+    {"Survey_Departure_Day", 4, 7, 2},
+    {"Port_of_Departure", 4, 9, 32},
+    {"Survey_Arrival_Year", 4, 41, 4},
+    {"Survey_Arrival_Month", 4, 45, 2},
+    {"Survey_Arrival_Day", 4, 47, 2},
+    {"Port_of_Arrival", 4, 49, 30},
+    {"Navigation_Instrumentation", 5, 1, 40},
+    {"Geodetic_Datum_Position_Determination_Method", 5, 41, 38},
+    {"Bathymetry_Instrumentation", 6, 1, 40},
+    {"Bathymetry_Add_Forms_of_Data", 6, 41, 38},
+    {"Magnetics_Instrumentation", 7, 1, 40},
+    {"Magnetics_Add_Forms_of_Data", 7, 41, 38},
+    {"Gravity_Instrumentation", 8, 1, 40},
+    {"Gravity_Add_Forms_of_Data", 8, 41, 38},
+    {"Seismic_Instrumentation", 9, 1, 40},
+    {"Seismic_Data_Formats", 9, 41, 38},
+    {"Format_Type", 10, 1, 1},
+    {"Format_Description", 10, 2, 74},
+    {"Topmost_Latitude", 11, 41, 3},
+    {"Bottommost_Latitude", 11, 44, 3},
+    {"Leftmost_Longitude", 11, 47, 4},
+    {"Rightmost_Longitude", 11, 51, 4},
+    {"Bathymetry_Digitizing_Rate", 12, 1, 2},
+    {"Bathymetry_Sampling_Rate", 12, 3, 12},
+    {"Bathymetry_Assumed_Sound_Velocity", 12, 15, 5},
+    {"Bathymetry_Datum_Code", 12, 20, 2},
+    {"Bathymetry_Interpolation_Scheme", 12, 22, 56},
+    {"Magnetics_Digitizing_Rate", 13, 1, 2},
+    {"Magnetics_Sampling_Rate", 13, 3, 2},
+    {"Magnetics_Sensor_Tow_Distance", 13, 5, 4},
+    {"Magnetics_Sensor_Depth", 13, 9, 5},
+    {"Magnetics_Sensor_Separation", 13, 14, 3},
+    {"Magnetics_Ref_Field_Code", 13, 17, 2},
+    {"Magnetics_Ref_Field", 13, 19, 12},
+    {"Magnetics_Method_Applying_Res_Field", 13, 31, 47},
+    {"Gravity_Digitizing_Rate", 14, 1, 2},
+    {"Gravity_Sampling_Rate", 14, 3, 1},
+    {"Gravity_Theoretical_Formula_Code", 14, 4, 1},
+    {"Gravity_Theoretical_Formula", 14, 5, 17},
+    {"Gravity_Reference_System_Code", 14, 22, 1},
+    {"Gravity_Reference_System", 14, 23, 16},
+    {"Gravity_Corrections_Applied", 14, 39, 38},
+    {"Gravity_Departure_Base_Station", 15, 1, 7},
+    {"Gravity_Departure_Base_Station_Name", 15, 8, 33},
+    {"Gravity_Arrival_Base_Station", 15, 41, 7},
+    {"Gravity_Arrival_Base_Station_Name", 15, 48, 31},
+    {"Number_of_Ten_Degree_Identifiers", 16, 1, 2},
+    {"Additional_Documentation_1", 18, 1, 78},
+    {"Additional_Documentation_2", 19, 1, 78},
+    {"Additional_Documentation_3", 20, 1, 78},
+    {"Additional_Documentation_4", 21, 1, 78},
+    {"Additional_Documentation_5", 22, 1, 78},
+    {"Additional_Documentation_6", 23, 1, 78},
+    {"Additional_Documentation_7", 24, 1, 78},
+    {NULL, 0, 0, 0}
+};
+
 int main(int argc, char **argv)
 {
 	char ninfile[BUFSIZ], dinfile[BUFSIZ], minfile[BUFSIZ], ginfile[BUFSIZ], cruiseid[BUFSIZ];
+    char hdrparfile[BUFSIZ] = "", hdrfile[BUFSIZ] = "", statsfile[BUFSIZ] = "";
     char pingno[BUFSIZ];
 	int i, error=0, nfields=0;
 
@@ -139,6 +272,17 @@ int main(int argc, char **argv)
         {   5,  0,   0,  0,  0,  0,  NAN,NAN,NAN,'9',NAN,  NAN,"99\0",'9', NAN, NAN,NAN,  '9', NAN,NAN, NAN,     NAN, NAN,NAN,NAN,'9',"KM","99999","999999",MAXFLOAT, MAXFLOAT, "\0",  NULL, '\0', 0}
     };
     struct RECORD *current = NULL;
+    static struct HDRSTATS stats = {
+        0, 0, 0, 0, 0, 0.0, 0.0, 90.0, -90.0, 180.0, -180.0, 360.0, 0.0, 0.0, {0},
+        {{"depth", 0, MAXFLOAT, -MAXFLOAT, NAN, 0.0},
+         {"mtf1", 0, MAXFLOAT, -MAXFLOAT, NAN, 0.0},
+         {"mag", 0, MAXFLOAT, -MAXFLOAT, NAN, 0.0},
+         {"diur", 0, MAXFLOAT, -MAXFLOAT, NAN, 0.0},
+         {"msd", 0, MAXFLOAT, -MAXFLOAT, NAN, 0.0},
+         {"gobs", 0, MAXFLOAT, -MAXFLOAT, NAN, 0.0},
+         {"eot", 0, MAXFLOAT, -MAXFLOAT, NAN, 0.0},
+         {"faa", 0, MAXFLOAT, -MAXFLOAT, NAN, 0.0}}
+    };
     drec->decyr = mrec->decyr = grec->decyr = MAXFLOAT;
 
 	for (i = 1; !error && i < argc; i++) {	/* Process infiles */
@@ -195,16 +339,31 @@ int main(int argc, char **argv)
                 grec->use=1; nfields++;
                 grec->prevdecyr = grec->decyr;
 				break;
+			case 'H':
+				strcpy (hdrparfile,&argv[i][3]);
+				break;
+			case 'h':
+				strcpy (hdrfile,&argv[i][3]);
+				break;
+			case 's':
+				strcpy (statsfile,&argv[i][3]);
+				break;
 			default:		/* Options not recognized */
 				error = 1;
 				break;
 		}
 	}
 
+	if (hdrparfile[0] && !hdrfile[0]) error = 1;	/* -H only applies to the header written by -h */
+
 	if (error || nfields < 1 || nfields > 4) {	/* Display usage */
 		fprintf(stderr,"udmerge - Merge cruiseid_cdpth, cruiseid_cmagy, and cruiseid_cgrav files.\n\n");
-		fprintf(stderr,"usage: udmerge -i <cruiseid> [-n cruiseid_pos-mv] [-d cruiseid_cdpth] [-m cruiseid_cmagy] [-g cruiseid_cgrav]\n\n");
+		fprintf(stderr,"usage: udmerge -i <cruiseid> [-n cruiseid_pos-mv] [-d cruiseid_cdpth] [-m cruiseid_cmagy] [-g cruiseid_cgrav]\n");
+		fprintf(stderr,"               [-H hdrpar.txt] [-h cruiseid.h77] [-s cruiseid.stats]\n\n");
         fprintf(stderr,"\t-i option required. One or more of n, d, m and g options required. \n");
+        fprintf(stderr,"\t-h writes a 24-line MGD77 header built from statistics gathered during the merge.\n");
+        fprintf(stderr,"\t-H reads header items for -h in mgd77header -H format (Item_Name value). Requires -h.\n");
+        fprintf(stderr,"\t-s writes per-field counts, min/max and largest time gaps gathered during the merge.\n");
 		fprintf(stderr,"\tInput files use SOEST formats for corrected underway data.\n\n");
         fprintf(stderr,"\tFor example:\n\n");
         
@@ -256,6 +415,7 @@ int main(int argc, char **argv)
             fprintf (stdout, "recno: %d, gread: %d, current=: %.08f, grec=: %.08f grec->decyr-grec->prevdecyr (%.12f) >= DECYR_SLOP(%.12f)? %d\n",i,gread,current->decyr,grec->decyr,grec->decyr-grec->prevdecyr,DECYR_SLOP,grec->decyr-grec->prevdecyr >= DECYR_SLOP);
         #endif
         kmoutput (outrec);
+        if (hdrfile[0] || statsfile[0]) accumulate (&stats, outrec);
         reset (outrec,initial);
         if (nread) {
             nrec->prevdecyr=nrec->decyr;
@@ -296,6 +456,9 @@ int main(int argc, char **argv)
 	if (drec->input) fclose(drec->input);
 	if (mrec->input) fclose(mrec->input);
 	if (grec->input) fclose(grec->input);
+
+    if (hdrfile[0]) writeheader (&stats, cruiseid, hdrparfile, hdrfile);
+    if (statsfile[0]) writestats (&stats, statsfile);
 }
 
 void kmoutput (struct RECORD *out)
@@ -304,6 +467,228 @@ void kmoutput (struct RECORD *out)
     out->lat,out->lon,out->ptc,out->twt,out->depth,out->bcc,out->btc,out->mtf1,out->mtf2,out->mag,out->msens,out->diur,out->msd,out->gobs,out->eot,out->faa,out->nqc,out->id,out->sln,out->sspn);
 }
 
+void accumulate (struct HDRSTATS *st, struct RECORD *out)
+{
+    double t, lon, lon360;
+    
+    /* Records without position are dropped from the merged file, so skip them here too */
+    if (isnan(out->lat) || isnan(out->lon)) return;
+    
+    /* Merged data may be in -180/180 or, for tracks crossing the dateline, 0/360 */
+    lon = out->lon > 180.0 ? out->lon - 360.0 : out->lon;
+    
+    t = epochsec (out);
+    if (st->n == 0) {
+        st->first_yy = out->yy;
+        st->first_jjj = out->jjj;
+        st->first_t = t;
+    } else if (t - st->last_t > st->navgap) st->navgap = t - st->last_t;
+    st->last_yy = out->yy;
+    st->last_jjj = out->jjj;
+    st->last_t = t;
+    st->n++;
+    
+    if (out->lat < st->south) st->south = out->lat;
+    if (out->lat > st->north) st->north = out->lat;
+    /* Track longitudes in both -180/180 and 0/360 so a dateline crossing can be detected */
+    if (lon < st->west) st->west = lon;
+    if (lon > st->east) st->east = lon;
+    lon360 = lon < 0.0 ? lon + 360.0 : lon;
+    if (lon360 < st->west360) st->west360 = lon360;
+    if (lon360 > st->east360) st->east360 = lon360;
+    st->tdi[tendegid (out->lat, lon)] = 1;
+    
+    fieldstats (&st->field[0], out->depth, t);
+    fieldstats (&st->field[1], out->mtf1, t);
+    fieldstats (&st->field[2], out->mag, t);
+    fieldstats (&st->field[3], out->diur, t);
+    fieldstats (&st->field[4], out->msd, t);
+    fieldstats (&st->field[5], out->gobs, t);
+    fieldstats (&st->field[6], out->eot, t);
+    fieldstats (&st->field[7], out->faa, t);
+}
+
+void fieldstats (struct FIELDSTATS *f, double value, double t)
+{
+    if (isnan(value)) return;
+    if (value < f->min) f->min = value;
+    if (value > f->max) f->max = value;
+    if (f->n && t - f->last > f->gap) f->gap = t - f->last;
+    f->last = t;
+    f->n++;
+}
+
+void writeheader (struct HDRSTATS *st, char *cruiseid, char *hdrparfile, char *hdrfile)
+{
+    char hdr[MGD77_HDR_RECS][MGD77_HDR_LEN+1], line[BUFSIZ], value[BUFSIZ], *c;
+    int i, k, ntdi, len;
+    double west, east;
+    time_t now;
+    struct tm *today;
+    FILE *fp;
+    
+    for (i = 0; i < MGD77_HDR_RECS; i++) {
+        memset (hdr[i], ' ', MGD77_HDR_LEN);
+        sprintf (&hdr[i][MGD77_HDR_LEN-2], "%02d", i+1);
+    }
+    
+    /* Items known without the data */
+    setitem (hdr, "Record_Type", "4");
+    setitem (hdr, "Survey_Identifier", cruiseid);
+    setitem (hdr, "Format_Acronym", "MGD77");
+    now = time (NULL);
+    today = gmtime (&now);
+    sprintf (value, "%04d", today->tm_year + 1900); setitem (hdr, "File_Creation_Year", value);
+    sprintf (value, "%02d", today->tm_mon + 1); setitem (hdr, "File_Creation_Month", value);
+    sprintf (value, "%02d", today->tm_mday); setitem (hdr, "File_Creation_Day", value);
+    
+    /* Items computed during the merge */
+    sprintf (value, "%c%c%c00", st->field[0].n ? '1' : '0', st->field[1].n || st->field[2].n ? '1' : '0', st->field[5].n || st->field[7].n ? '1' : '0');
+    setitem (hdr, "Parameters_Surveyed_Code", value);
+    if (st->n) {
+        sprintf (value, "%04d", st->first_yy); setitem (hdr, "Survey_Departure_Year", value);
+        sprintf (value, "%02d", ordday2mo (st->first_jjj, st->first_yy)); setitem (hdr, "Survey_Departure_Month", value);
+        sprintf (value, "%02d", ordday2dd (st->first_jjj, st->first_yy)); setitem (hdr, "Survey_Departure_Day", value);
+        sprintf (value, "%04d", st->last_yy); setitem (hdr, "Survey_Arrival_Year", value);
+        sprintf (value, "%02d", ordday2mo (st->last_jjj, st->last_yy)); setitem (hdr, "Survey_Arrival_Month", value);
+        sprintf (value, "%02d", ordday2dd (st->last_jjj, st->last_yy)); setitem (hdr, "Survey_Arrival_Day", value);
+        
+        lonextent (st, &west, &east);
+        sprintf (value, "%+03d", (int)ceil (st->north)); setitem (hdr, "Topmost_Latitude", value);
+        sprintf (value, "%+03d", (int)floor (st->south)); setitem (hdr, "Bottommost_Latitude", value);
+        sprintf (value, "%+04d", (int)floor (west)); setitem (hdr, "Leftmost_Longitude", value);
+        sprintf (value, "%+04d", (int)ceil (east)); setitem (hdr, "Rightmost_Longitude", value);
+        
+        /* Ten degree identifiers fill record 16 from column 4 and continue on record 17 */
+        for (k = ntdi = len = 0; k < 10000; k++) {
+            if (!st->tdi[k]) continue;
+            if (ntdi == MGD77_MAX_TDI) {
+                fprintf (stderr, "udmerge: more than %d ten degree identifiers, remainder omitted from header\n", MGD77_MAX_TDI);
+                break;
+            }
+            len += sprintf (&line[len], "%04d,", k);
+            ntdi++;
+        }
+        sprintf (&line[len], "9999,");
+        sprintf (value, "%2d", ntdi); setitem (hdr, "Number_of_Ten_Degree_Identifiers", value);
+        memcpy (&hdr[15][3], line, len+5 > 75 ? 75 : len+5);
+        if (len+5 > 75) memcpy (&hdr[16][0], &line[75], len+5-75);
+    }
+    
+    /* Items supplied by the caller override anything computed above */
+    if (hdrparfile[0]) {
+        fp = fopen (hdrparfile, "r");
+        if (fp == NULL) {
+            fprintf(stderr,"*** Can't open header items file ***\n");
+            exit(0);
+        }
+        while (fgets (line,BUFSIZ,fp)) {
+            if ((c = strpbrk (line,"\r\n"))) *c = '\0';
+            if (line[0] == '#' || (c = strchr (line,' ')) == NULL) continue;
+            *c++ = '\0';
+            setitem (hdr, line, c);
+        }
+        fclose (fp);
+    }
+    
+    fp = fopen (hdrfile, "w");
+    if (fp == NULL) {
+        fprintf(stderr,"*** Can't open header output file ***\n");
+        exit(0);
+    }
+    for (i = 0; i < MGD77_HDR_RECS; i++) fprintf (fp, "%s\n", hdr[i]);
+    fclose (fp);
+}
+
+void writestats (struct HDRSTATS *st, char *statsfile)
+{
+    int i;
+    double west, east;
+    char start[BUFSIZ], end[BUFSIZ];
+    FILE *fp;
+    
+    fp = fopen (statsfile, "w");
+    if (fp == NULL) {
+        fprintf(stderr,"*** Can't open statistics output file ***\n");
+        exit(0);
+    }
+    /* Survey time span and extent, with west/east chosen as for the header */
+    if (st->n) {
+        lonextent (st, &west, &east);
+        isotime (st->first_t, start);
+        isotime (st->last_t, end);
+        fprintf (fp, "start\t%s\nend\t%s\n", start, end);
+        fprintf (fp, "south\t%.9f\nnorth\t%.9f\nwest\t%.9f\neast\t%.9f\n", st->south, st->north, west, east);
+    }
+    /* Navigation first, then one line per merged data field; gaps are in seconds */
+    fprintf (fp, "#field\tn\tmin\tmax\tgap\n");
+    fprintf (fp, "nav\t%ld\tnan\tnan\t%.1f\n", st->n, st->navgap);
+    for (i = 0; i < NSTATFIELDS; i++) {
+        if (st->field[i].n)
+            fprintf (fp, "%s\t%ld\t%f\t%f\t%.1f\n", st->field[i].name, st->field[i].n, st->field[i].min, st->field[i].max, st->field[i].gap);
+        else
+            fprintf (fp, "%s\t0\tnan\tnan\tnan\n", st->field[i].name);
+    }
+    fclose (fp);
+}
+
+void lonextent (struct HDRSTATS *st, double *west, double *east)
+{
+    /* Use whichever longitude range is narrower; 0/360 wins when the survey crosses the dateline */
+    *west = st->west; *east = st->east;
+    if (st->east360 - st->west360 < st->east - st->west) {
+        *west = st->west360 > 180.0 ? st->west360 - 360.0 : st->west360;
+        *east = st->east360 > 180.0 ? st->east360 - 360.0 : st->east360;
+    }
+}
+
+void isotime (double t, char *text)
+{
+    time_t sec = (time_t)floor (t);
+    struct tm *tm = gmtime (&sec);
+    
+    sprintf (text, "%04d-%02d-%02dT%02d:%02d:%06.3f", tm->tm_year + 1900, tm->tm_mon + 1, tm->tm_mday, tm->tm_hour, tm->tm_min, tm->tm_sec + (t - sec));
+}
+
+void setitem (char hdr[MGD77_HDR_RECS][MGD77_HDR_LEN+1], char *name, char *value)
+{
+    int i, len;
+    
+    for (i = 0; hdritems[i].name; i++) {
+        if (strcmp (hdritems[i].name, name)) continue;
+        len = strlen (value);
+        if (len > hdritems[i].width) len = hdritems[i].width;
+        memset (&hdr[hdritems[i].seq-1][hdritems[i].col-1], ' ', hdritems[i].width);
+        memcpy (&hdr[hdritems[i].seq-1][hdritems[i].col-1], value, len);
+        return;
+    }
+    fprintf (stderr, "udmerge: unknown header item %s ignored\n", name);
+}
+
+double epochsec (struct RECORD *rec)
+{
+    int y = rec->yy - 1;
+    long days;
+    
+    /* Days since 1970-01-01 */
+    days = 365L*(rec->yy-1970) + (y/4 - y/100 + y/400) - (1969/4 - 1969/100 + 1969/400) + rec->jjj - 1;
+    return ((days*24.0 + rec->hh)*60.0 + rec->mm)*60.0 + rec->ss;
+}
+
+int tendegid (double lat, double lon)
+{
+    int quadrant, ilat, ilon;
+    
+    /* WMO quadrant: 1 NE, 3 SE, 5 SW, 7 NW */
+    if (lat >= 0.0) quadrant = lon >= 0.0 ? 1 : 7;
+    else quadrant = lon >= 0.0 ? 3 : 5;
+    ilat = (int)(fabs (lat) / 10.0);
+    ilon = (int)(fabs (lon) / 10.0);
+    if (ilat > 8) ilat = 8;
+    if (ilon > 17) ilon = 17;
+    return quadrant*1000 + ilat*100 + ilon;
+}
+
 int setoutput (struct RECORD *rec, struct RECORD *curr, struct RECORD *out)
 {
     #ifdef DEBUG